@@ -0,0 +1,58 @@
+#include <QSettings>
+#include "deviceprofile.h"
+
+namespace {
+
+QSettings& settings() {
+    static QSettings store("edge-qt", "edge");
+    return store;
+}
+
+}
+
+QString deviceProfileKey(unsigned short vid, unsigned short pid, const QString& serial)
+{
+    QString key = QString("%1_%2").arg(vid, 4, 16, QChar('0')).arg(pid, 4, 16, QChar('0'));
+    // slashes would turn into nested settings groups
+    QString clean_serial = QString(serial).replace('/', '_').replace('\\', '_');
+    return clean_serial.isEmpty() ? key : key + "_" + clean_serial;
+}
+
+DeviceProfile loadDeviceProfile(const QString& key)
+{
+    QSettings& s = settings();
+    s.beginGroup("devices/" + key);
+    DeviceProfile profile;
+    profile.maxWriteRate = s.value("maxWriteRate", 0.0).toDouble();
+    profile.maxReadRate = s.value("maxReadRate", 0.0).toDouble();
+    profile.writesMeasured = s.value("writesMeasured", false).toBool();
+    profile.readsMeasured = s.value("readsMeasured", false).toBool();
+    profile.writeErrorOnset = s.value("writeErrorOnset", 0.0).toDouble();
+    profile.readErrorOnset = s.value("readErrorOnset", 0.0).toDouble();
+    profile.writeRateLimit = s.value("writeRateLimit", 0.0).toDouble();
+    profile.readRateLimit = s.value("readRateLimit", 0.0).toDouble();
+    profile.writeP99Us = s.value("writeP99Us", 0.0).toDouble();
+    profile.readP99Us = s.value("readP99Us", 0.0).toDouble();
+    profile.measuredAt = s.value("measuredAt").toString();
+    s.endGroup();
+    return profile;
+}
+
+void saveDeviceProfile(const QString& key, const DeviceProfile& profile)
+{
+    QSettings& s = settings();
+    s.beginGroup("devices/" + key);
+    s.setValue("writesMeasured", profile.writesMeasured);
+    s.setValue("readsMeasured", profile.readsMeasured);
+    s.setValue("maxWriteRate", profile.maxWriteRate);
+    s.setValue("maxReadRate", profile.maxReadRate);
+    s.setValue("writeErrorOnset", profile.writeErrorOnset);
+    s.setValue("readErrorOnset", profile.readErrorOnset);
+    s.setValue("writeRateLimit", profile.writeRateLimit);
+    s.setValue("readRateLimit", profile.readRateLimit);
+    s.setValue("writeP99Us", profile.writeP99Us);
+    s.setValue("readP99Us", profile.readP99Us);
+    s.setValue("measuredAt", profile.measuredAt);
+    s.endGroup();
+    s.sync();
+}
@@ -0,0 +1,29 @@
+#ifndef DEVICEPROFILE_H
+#define DEVICEPROFILE_H
+
+#include <QString>
+
+// what stress test found out about particular mouse, stored in QSettings.
+// rates are requests per second. max rate is 0 if even the slowest step had errors,
+// so "measured" flags tell that apart from not tested
+struct DeviceProfile {
+    bool writesMeasured = false;
+    bool readsMeasured = false;
+    double maxWriteRate = 0;
+    double maxReadRate = 0;
+    double writeErrorOnset = 0;     // 0 if ramp ended without errors
+    double readErrorOnset = 0;
+    double writeRateLimit = 0;      // what requests are paced by, 0 means unthrottled
+    double readRateLimit = 0;
+    double writeP99Us = 0;
+    double readP99Us = 0;
+    QString measuredAt;
+};
+
+// key is built from VID, PID and serial number, so two mice of the same model keep separate profiles
+QString deviceProfileKey(unsigned short vid, unsigned short pid, const QString& serial);
+
+DeviceProfile loadDeviceProfile(const QString& key);
+void saveDeviceProfile(const QString& key, const DeviceProfile& profile);
+
+#endif // DEVICEPROFILE_H
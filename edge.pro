@@ -1,16 +1,32 @@
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 
 CONFIG += c++17
 LIBS += -lhidapi-hidraw
 
 SOURCES += \
+    deviceprofile.cpp \
+    edgeinput.cpp \
+    latencyprobe.cpp \
+    ledpreview.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    motionanalyzer.cpp \
+    motionrecorder.cpp \
+    paletteextractor.cpp \
+    throughputprobe.cpp
 
 HEADERS += \
-    mainwindow.h
+    deviceprofile.h \
+    edgeinput.h \
+    latencyprobe.h \
+    ledpreview.h \
+    mainwindow.h \
+    motionanalyzer.h \
+    motionrecorder.h \
+    paletteextractor.h \
+    throughputprobe.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
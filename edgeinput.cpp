@@ -0,0 +1,88 @@
+#include <linux/input.h>
+#include <dirent.h>
+#include <ctime>
+#include <fstream>
+#include <cstdlib>
+#include "edgeinput.h"
+
+using namespace std;
+
+namespace {
+
+string readSysfsLine(const string& path) {
+    ifstream file(path);
+    string line;
+    getline(file, line);
+    return line;
+}
+
+unsigned long readSysfsHex(const string& path) {
+    // bitmasks may be split into several words, lowest bits are in the last one
+    string line = readSysfsLine(path);
+    size_t space = line.find_last_of(' ');
+    if (space != string::npos) line = line.substr(space + 1);
+    return strtoul(line.c_str(), nullptr, 16);
+}
+
+}
+
+string findEdgeEventNode(unsigned short vid, unsigned short pid)
+{
+    DIR* dir = opendir("/sys/class/input");
+    if (!dir) return {};
+
+    string found;
+    while (dirent* entry = readdir(dir)) {
+        string name = entry->d_name;
+        if (name.rfind("event", 0) != 0) continue;
+
+        string device = "/sys/class/input/" + name + "/device/";
+        if (readSysfsHex(device + "id/vendor") != vid) continue;
+        if (readSysfsHex(device + "id/product") != pid) continue;
+
+        // REL_X and REL_Y bits, keyboard/consumer interfaces don't have them
+        if ((readSysfsHex(device + "capabilities/rel") & 0x03) != 0x03) continue;
+
+        found = "/dev/input/" + name;
+        break;
+    }
+    closedir(dir);
+    return found;
+}
+
+string findHidrawForEventNode(const string& eventNode)
+{
+    size_t slash = eventNode.find_last_of('/');
+    string name = eventNode.substr(slash == string::npos ? 0 : slash + 1);
+
+    // eventN/device is inputM, its parent is the HID interface with hidraw child
+    DIR* dir = opendir(("/sys/class/input/" + name + "/device/device/hidraw").c_str());
+    if (!dir) return {};
+
+    string found;
+    while (dirent* entry = readdir(dir)) {
+        string child = entry->d_name;
+        if (child.rfind("hidraw", 0) == 0) {
+            found = "/dev/" + child;
+            break;
+        }
+    }
+    closedir(dir);
+    return found;
+}
+
+int64_t monotonicMicroseconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t eventMicroseconds(const input_event& ev)
+{
+#ifdef input_event_sec
+    return int64_t(ev.input_event_sec) * 1000000 + ev.input_event_usec;
+#else
+    return int64_t(ev.time.tv_sec) * 1000000 + ev.time.tv_usec;
+#endif
+}
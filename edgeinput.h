@@ -0,0 +1,24 @@
+#ifndef EDGEINPUT_H
+#define EDGEINPUT_H
+
+#include <string>
+#include <cstdint>
+
+struct input_event;
+
+// lookup of kernel input nodes that belong to the Edge (linux only, via sysfs).
+// mouse exposes several interfaces, we want the one which reports relative motion
+
+// "/dev/input/eventN" of the motion interface, empty string if mouse isn't connected
+std::string findEdgeEventNode(unsigned short vid, unsigned short pid);
+
+// "/dev/hidrawN" of the same HID interface which feeds given event node, empty string if there is none
+std::string findHidrawForEventNode(const std::string& eventNode);
+
+// monotonic clock in microseconds, same clock evdev timestamps are switched to
+int64_t monotonicMicroseconds();
+
+// kernel timestamp of evdev event in microseconds
+int64_t eventMicroseconds(const input_event& ev);
+
+#endif // EDGEINPUT_H
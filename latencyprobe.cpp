@@ -0,0 +1,181 @@
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+#include "latencyprobe.h"
+#include "edgeinput.h"
+
+using namespace std;
+
+namespace {
+
+struct EvdevFrame {
+    int64_t kernel;
+    int64_t read;
+};
+
+vector<int> allowedCpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    vector<int> cpus;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// pins calling thread and tries to make it realtime, returns false if SCHED_FIFO isn't allowed
+bool pinCurrentThread(int cpu) {
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+    sched_param param = {};
+    param.sched_priority = 50;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+// waits for data until deadline, false when time is over
+bool waitReadable(int fd, int64_t deadline) {
+    while (true) {
+        int64_t left_ms = (deadline - monotonicMicroseconds()) / 1000;
+        if (left_ms <= 0) return false;
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, int(min<int64_t>(left_ms, 100))) > 0) return true;
+    }
+}
+
+void readHidraw(int fd, int cpu, int64_t deadline, vector<int64_t>& reads, atomic<bool>& realtime) {
+    if (!pinCurrentThread(cpu)) realtime = false;
+
+    uint8_t report[64];
+    while (waitReadable(fd, deadline)) {
+        // one read() is exactly one report on hidraw
+        while (read(fd, report, sizeof(report)) > 0) {
+            reads.push_back(monotonicMicroseconds());
+        }
+    }
+}
+
+void readEvdev(int fd, int cpu, int64_t deadline, vector<EvdevFrame>& frames, atomic<bool>& realtime) {
+    if (!pinCurrentThread(cpu)) realtime = false;
+
+    input_event events[64];
+    while (waitReadable(fd, deadline)) {
+        ssize_t bytes;
+        while ((bytes = read(fd, events, sizeof(events))) > 0) {
+            int64_t now = monotonicMicroseconds();
+            for (size_t i = 0; i < size_t(bytes) / sizeof(input_event); ++i) {
+                // buttons too, hidraw side can't tell them from motion
+                const input_event& ev = events[i];
+                if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+                    frames.push_back({eventMicroseconds(ev), now});
+                }
+            }
+        }
+    }
+}
+
+LatencyPercentiles percentiles(vector<double> values) {
+    LatencyPercentiles result;
+    if (values.empty()) return result;
+    sort(values.begin(), values.end());
+    result.p50 = values[(values.size() - 1) / 2];
+    result.p99 = values[size_t((values.size() - 1) * 0.99)];
+    result.max = values.back();
+    return result;
+}
+
+}
+
+LatencyResult measureInputLatency(const string& hidrawNode, const string& eventNode,
+                                  int seconds, int pollRateHz)
+{
+    LatencyResult result;
+
+    int hidraw_fd = open(hidrawNode.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (hidraw_fd < 0) {
+        result.error = "can't open " + hidrawNode + ": " + strerror(errno);
+        return result;
+    }
+    int event_fd = open(eventNode.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (event_fd < 0) {
+        result.error = "can't open " + eventNode + ": " + strerror(errno);
+        close(hidraw_fd);
+        return result;
+    }
+    // hidraw reads are stamped with monotonic clock too, so all three stamps are comparable
+    int clock_id = CLOCK_MONOTONIC;
+    ioctl(event_fd, EVIOCSCLOCKID, &clock_id);
+
+    // no allocations while measuring
+    size_t capacity = size_t(max(seconds, 1)) * max(pollRateHz, 1000) * 2;
+    vector<int64_t> hidraw_reads;
+    vector<EvdevFrame> evdev_frames;
+    hidraw_reads.reserve(capacity);
+    evdev_frames.reserve(capacity);
+
+    // last CPUs are usually the least busy with interrupts
+    vector<int> cpus = allowedCpus();
+    result.hidrawCpu = cpus.empty() ? -1 : cpus.back();
+    result.evdevCpu = cpus.size() > 1 ? cpus[cpus.size() - 2] : result.hidrawCpu;
+
+    atomic<bool> realtime{true};
+    int64_t deadline = monotonicMicroseconds() + int64_t(seconds) * 1000000;
+    thread hidraw_thread(readHidraw, hidraw_fd, result.hidrawCpu, deadline, ref(hidraw_reads), ref(realtime));
+    thread evdev_thread(readEvdev, event_fd, result.evdevCpu, deadline, ref(evdev_frames), ref(realtime));
+    hidraw_thread.join();
+    evdev_thread.join();
+    close(hidraw_fd);
+    close(event_fd);
+
+    result.realtime = realtime;
+    result.hidrawReports = hidraw_reads.size();
+    result.evdevFrames = evdev_frames.size();
+
+    // pairing in order, no window on the delay itself so the tail stays visible.
+    // slack covers hidraw reader waking up while kernel is still stamping the frame
+    const int64_t slack = 100;
+    vector<double> behind, hidraw_delivery, evdev_delivery;
+    size_t next = 0;
+    for (const EvdevFrame& frame : evdev_frames) {
+        while (next < hidraw_reads.size() && hidraw_reads[next] < frame.kernel - slack) {
+            ++next;
+            ++result.unmatchedHidraw;
+        }
+        if (next == hidraw_reads.size()) {
+            ++result.unmatchedEvdev;
+            continue;
+        }
+
+        behind.push_back(double(frame.read - hidraw_reads[next]));
+        hidraw_delivery.push_back(double(hidraw_reads[next] - frame.kernel));
+        evdev_delivery.push_back(double(frame.read - frame.kernel));
+        ++next;
+    }
+    result.unmatchedHidraw += hidraw_reads.size() - next;
+
+    result.matched = behind.size();
+    if (result.matched == 0) {
+        result.error = "no matching reports, mouse should be moving during measurement";
+        return result;
+    }
+    result.evdevBehindHidraw = percentiles(move(behind));
+    result.hidrawDelivery = percentiles(move(hidraw_delivery));
+    result.evdevDelivery = percentiles(move(evdev_delivery));
+    return result;
+}
@@ -0,0 +1,41 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <string>
+#include <cstddef>
+
+// end-to-end comparison of the two ways input report reaches userspace:
+// raw report from hidraw and decoded frame from evdev.
+// both nodes are read at the same time by two reader threads pinned to separate CPUs,
+// every report that changes something gives exactly one evdev frame, so they are paired in order of arrival.
+// report read before kernel stamped the frame can't belong to it, such reports are skipped as unmatched
+
+struct LatencyPercentiles {
+    double p50 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+struct LatencyResult {
+    std::string error;          // empty on success
+
+    size_t hidrawReports = 0;
+    size_t evdevFrames = 0;
+    size_t matched = 0;
+    size_t unmatchedHidraw = 0;  // reports without frame (nothing changed, other report IDs)
+    size_t unmatchedEvdev = 0;   // frames left without report, normally only at the very end
+    int hidrawCpu = -1;
+    int evdevCpu = -1;
+    bool realtime = false;      // got SCHED_FIFO for reader threads
+
+    // microseconds
+    LatencyPercentiles evdevBehindHidraw;   // evdev read - hidraw read, what input stack adds
+    LatencyPercentiles hidrawDelivery;      // hidraw read - kernel event timestamp
+    LatencyPercentiles evdevDelivery;       // evdev read - kernel event timestamp
+};
+
+// blocks for given time, mouse should be moving all along
+LatencyResult measureInputLatency(const std::string& hidrawNode, const std::string& eventNode,
+                                  int seconds, int pollRateHz);
+
+#endif // LATENCYPROBE_H
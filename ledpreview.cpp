@@ -0,0 +1,200 @@
+#include <QPainter>
+#include <QTimer>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <cmath>
+#include <algorithm>
+#include "ledpreview.h"
+
+using namespace std;
+
+namespace {
+
+// loop length of one effect cycle for each ledSpeedSlider position
+const int CyclePeriodMs[] = {4000, 2500, 1500};
+
+QRgb scaled(QRgb color, double k) {
+    k = clamp(k, 0.0, 1.0);
+    return qRgb(int(qRed(color) * k), int(qGreen(color) * k), int(qBlue(color) * k));
+}
+
+QRgb hue(double h, double k) {
+    h -= floor(h);
+    if (h >= 1.0) h = 0.0;
+    return scaled(QColor::fromHsvF(h, 1.0, 1.0).rgb(), k);
+}
+
+// comet head running across the strip, tail fades quadratically
+double tailIntensity(int led, int ledCount, double phase) {
+    const double tail_length = 6.0;
+    double head = phase * (ledCount + tail_length);
+    double distance = head - led;
+    if (distance < 0 || distance >= tail_length) return 0.0;
+    double k = 1.0 - distance / tail_length;
+    return k * k;
+}
+
+double heartbeat(double phase) {
+    auto pulse = [phase](double offset, double width) {
+        double x = (phase - offset) / width;
+        return exp(-x * x);
+    };
+    return max(pulse(0.10, 0.05), 0.7 * pulse(0.28, 0.05));
+}
+
+}
+
+LedPreview::LedPreview(QWidget *parent)
+    : QWidget(parent)
+{
+    // we fill whole rect ourselves, no need for Qt to erase background first
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumHeight(28);
+
+    frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    frameTimer->setInterval(1000 / FramesPerSecond);
+    connect(frameTimer, &QTimer::timeout, this, &LedPreview::advanceFrame);
+
+    setParameters(9, 1, 10, {});
+}
+
+QSize LedPreview::sizeHint() const {
+    return QSize(LedCount * 24, 28);
+}
+
+void LedPreview::setParameters(int modeId, int speed, int brightness, const vector<QColor>& palette)
+{
+    vector<QRgb> colors;
+    for (const QColor& color : palette) colors.push_back(color.rgb());
+    CacheKey key(modeId, clamp(speed, 0, 2), clamp(brightness, 0, 10), colors);
+
+    auto it = frameCache.find(key);
+    if (it == frameCache.end()) {
+        // palette editing can produce lots of sets, the least recently used one goes away
+        if (frameCache.size() >= MaxCachedSets) {
+            frameCache.erase(min_element(frameCache.begin(), frameCache.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUse < b.second.lastUse;
+            }));
+        }
+        it = frameCache.emplace(key, CachedFrames{renderFrames(key)}).first;
+    }
+    it->second.lastUse = ++cacheUseCounter;
+
+    frames = it->second.frames;
+    clock.restart();
+    currentFrame = 0;
+    updateTimerState(isVisible());
+    update();
+}
+
+QImage LedPreview::renderFrames(const CacheKey& key) const
+{
+    const int mode_id = get<0>(key);
+    const int speed = get<1>(key);
+    const double brightness = get<2>(key) / 10.0;
+    vector<QRgb> palette = get<3>(key);
+    if (palette.empty()) palette.push_back(qRgb(255, 255, 255));
+
+    const int colors = int(palette.size());
+    const int cycle_frames = CyclePeriodMs[speed] * FramesPerSecond / 1000;
+
+    int frame_count = cycle_frames;
+    if (mode_id == 2 || mode_id == 9) frame_count = 1;                  // steady, off
+    else if (mode_id == 5 || mode_id == 7) frame_count *= colors;       // one pass per palette color
+
+    QImage image(LedCount, frame_count, QImage::Format_RGB32);
+
+    for (int f = 0; f < frame_count; ++f) {
+        QRgb* row = reinterpret_cast<QRgb*>(image.scanLine(f));
+        double phase = double(f % cycle_frames) / cycle_frames;
+        QRgb pass_color = palette[(f / cycle_frames) % colors];
+
+        for (int i = 0; i < LedCount; ++i) {
+            double position = double(i) / LedCount;
+            QRgb pixel = qRgb(0, 0, 0);
+
+            switch (mode_id) {
+            case 0: // prismo
+                pixel = hue(position + phase, brightness);
+                break;
+            case 1: // breathe
+                pixel = scaled(palette[0], brightness * (0.5 - 0.5 * cos(2 * M_PI * phase)));
+                break;
+            case 2: // steady
+                pixel = scaled(palette[0], brightness);
+                break;
+            case 3: // neon
+                pixel = hue(phase, brightness);
+                break;
+            case 4: // tail
+                pixel = scaled(palette[0], brightness * tailIntensity(i, LedCount, phase));
+                break;
+            case 5: // colorful tail
+                pixel = scaled(pass_color, brightness * tailIntensity(i, LedCount, phase));
+                break;
+            case 6: // stream
+                pixel = hue(2 * position - phase, brightness);
+                break;
+            case 7: // reaction, simulating one click per pass
+                pixel = scaled(pass_color, brightness * exp(-5.0 * phase));
+                break;
+            case 8: // heart
+                pixel = scaled(palette[0], brightness * heartbeat(phase));
+                break;
+            default: // off
+                break;
+            }
+            row[i] = pixel;
+        }
+    }
+    return image;
+}
+
+void LedPreview::advanceFrame()
+{
+    int frame = int(clock.elapsed() * FramesPerSecond / 1000 % frames.height());
+    if (frame != currentFrame) {
+        currentFrame = frame;
+        update();
+    }
+}
+
+void LedPreview::updateTimerState(bool visible)
+{
+    // static modes and hidden tab don't need repaints at all
+    bool animated = visible && frames.height() > 1;
+    if (animated && !frameTimer->isActive()) frameTimer->start();
+    else if (!animated) frameTimer->stop();
+}
+
+void LedPreview::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    updateTimerState(true);
+}
+
+void LedPreview::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    updateTimerState(false);
+}
+
+void LedPreview::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(24, 24, 24));
+    if (frames.isNull()) return;
+
+    const QRgb* row = reinterpret_cast<const QRgb*>(frames.constScanLine(currentFrame));
+    const double cell_width = double(width()) / LedCount;
+    const int gap = 2;
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    for (int i = 0; i < LedCount; ++i) {
+        QRectF cell(i * cell_width + gap, gap, cell_width - 2 * gap, height() - 2 * gap);
+        painter.setBrush(QColor(row[i]));
+        painter.drawRoundedRect(cell, 3, 3);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef LEDPREVIEW_H
+#define LEDPREVIEW_H
+
+#include <QWidget>
+#include <QImage>
+#include <QColor>
+#include <QElapsedTimer>
+#include <vector>
+#include <map>
+#include <tuple>
+
+class QTimer;
+
+// animated simulation of firmware LED modes.
+// every parameter set is rendered once into a frame strip (one row per frame),
+// repaints only pick a row instead of computing the effect
+class LedPreview : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LedPreview(QWidget *parent = nullptr);
+
+    // speed is the ledSpeedSlider value (0 - slow, 2 - fast), brightness is 0..10
+    void setParameters(int modeId, int speed, int brightness, const std::vector<QColor>& palette);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void advanceFrame();
+
+private:
+    // mode, speed, brightness, palette
+    using CacheKey = std::tuple<int, int, int, std::vector<QRgb>>;
+
+    struct CachedFrames {
+        QImage frames;
+        quint64 lastUse = 0;
+    };
+
+    QImage renderFrames(const CacheKey& key) const;
+    void updateTimerState(bool visible);
+
+    QTimer* frameTimer;
+    QElapsedTimer clock;
+    std::map<CacheKey, CachedFrames> frameCache;
+    quint64 cacheUseCounter = 0;
+    QImage frames;
+    int currentFrame = 0;
+
+    static const int LedCount = 16;
+    static const int FramesPerSecond = 60;
+    static const size_t MaxCachedSets = 32;
+};
+
+#endif // LEDPREVIEW_H
@@ -12,10 +12,25 @@
 #include <QSpinBox>
 #include <QColorDialog>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+#include <QTimer>
+#include <QThread>
+#include <QDateTime>
+#include <QCloseEvent>
 #include <vector>
 #include <string>
 #include <cstring>
 #include "mainwindow.h"
+#include "ledpreview.h"
+#include "paletteextractor.h"
+#include "edgeinput.h"
+#include "motionrecorder.h"
+#include "motionanalyzer.h"
+#include "latencyprobe.h"
+#include "throughputprobe.h"
 
 using namespace std;
 
@@ -38,6 +53,47 @@ const map <int, uint8_t>&getDpiTable() {
     return DpiTable;
 };
 
+// side by side comparison of recordings, one column per file
+QString motionReportHtml(const QStringList& paths) {
+    QString header = "<tr><th></th>";
+    QString rows[11];
+    const char* names[11] = {"angle snap", "ripple control", "polling rate", "reports", "duration",
+                             "strokes", "straightness", "angular deviation", "lateral jitter",
+                             "jitter peak", "jitter low / mid / high"};
+
+    for (const QString& path : paths) {
+        header += "<th>" + QFileInfo(path).fileName().toHtmlEscaped() + "</th>";
+
+        MotionRecording recording;
+        string error;
+        if (!loadMotionRecording(path.toStdString(), recording, error)) {
+            rows[0] += "<td>" + QString::fromStdString(error).toHtmlEscaped() + "</td>";
+            for (int i = 1; i < 11; ++i) rows[i] += "<td>-</td>";
+            continue;
+        }
+        MotionAnalysis a = analyzeMotion(recording);
+
+        QString values[11] = {
+            (recording.sensorPerf & 0x01) ? "on" : "off",
+            (recording.sensorPerf & 0x02) ? "on" : "off",
+            QString("%1 Hz").arg(recording.pollRateHz),
+            QString::number(a.samples),
+            QString("%1 s").arg(a.durationSeconds, 0, 'f', 1),
+            QString::number(a.strokes),
+            QString::number(a.straightness, 'f', 4),
+            QString("%1°").arg(a.angularDeviationDeg, 0, 'f', 2),
+            QString("%1 counts").arg(a.lateralJitterRms, 0, 'f', 2),
+            QString("%1 Hz").arg(a.jitterPeakHz, 0, 'f', 1),
+            QString("%1 / %2 / %3").arg(a.jitterBands[0], 0, 'f', 2).arg(a.jitterBands[1], 0, 'f', 2).arg(a.jitterBands[2], 0, 'f', 2)
+        };
+        for (int i = 0; i < 11; ++i) rows[i] += "<td>" + values[i] + "</td>";
+    }
+
+    QString html = "<table cellpadding=3>" + header + "</tr>";
+    for (int i = 0; i < 11; ++i) html += QString("<tr><td>%1</td>").arg(names[i]) + rows[i] + "</tr>";
+    return html + "</table>";
+}
+
 int findClosestSupportedDpi(int targetDpi) {
     const auto& DpiTable = getDpiTable();
 
@@ -57,7 +113,7 @@ int findClosestSupportedDpi(int targetDpi) {
 }
 
 MainWindow::MainWindow(QWidget *parent)
-    : QWidget(parent)
+    : QWidget(parent), motionRecorder(new MotionRecorder)
 {
     if (hid_init()) {
         QMessageBox::critical(this, "error", "can't initialize hidapi.");
@@ -74,9 +130,21 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // stress test still holds hidapi handles
+    if (throughputWatcher) throughputWatcher->waitForFinished();
     hid_exit();
 }
 
+void MainWindow::closeEvent(QCloseEvent *event)
+{
+    if (throughputWatcher) {
+        statusLabel->setText("stress test is running, the window can be closed when it ends.");
+        event->ignore();
+        return;
+    }
+    QWidget::closeEvent(event);
+}
+
 void MainWindow::setupUI() {
     setWindowTitle("ZET/ARDOR GAMING Edge Configurator");
     setMinimumSize(700, 597);
@@ -177,6 +245,33 @@ QWidget* MainWindow::PerformanceTab() {
     layout->addRow(angleSnapCheck);
     layout->addRow(rippleControlCheck);
 
+    // recorder lets to see what snap/ripple really do with motion
+    QWidget *motionPanel = new QWidget();
+    QHBoxLayout *motionLayout = new QHBoxLayout(motionPanel);
+    motionLayout->setContentsMargins(0, 0, 0, 0);
+
+    motionRecordButton = new QPushButton("record...");
+    connect(motionRecordButton, &QPushButton::clicked, this, &MainWindow::toggleMotionRecording);
+    motionAnalyzeButton = new QPushButton("analyze...");
+    connect(motionAnalyzeButton, &QPushButton::clicked, this, &MainWindow::analyzeMotionRecordings);
+
+    motionLayout->addWidget(motionRecordButton);
+    motionLayout->addWidget(motionAnalyzeButton);
+    motionLayout->addStretch();
+    layout->addRow("motion recording:", motionPanel);
+
+    latencyButton = new QPushButton("measure...");
+    connect(latencyButton, &QPushButton::clicked, this, &MainWindow::runLatencyMeasurement);
+    layout->addRow("hidraw vs evdev latency:", latencyButton);
+
+    QPushButton *throughputButton = new QPushButton("stress test...");
+    connect(throughputButton, &QPushButton::clicked, this, &MainWindow::runThroughputTest);
+    layout->addRow("device throughput:", throughputButton);
+
+    motionRecordTimer = new QTimer(this);
+    motionRecordTimer->setInterval(500);
+    connect(motionRecordTimer, &QTimer::timeout, this, &MainWindow::updateMotionRecordingStatus);
+
     layout->setFieldGrowthPolicy(QFormLayout::AllNonFixedFieldsGrow);
 
     return tab;
@@ -205,12 +300,23 @@ QWidget* MainWindow::LedTab() {
     ledBrightnessSlider->setTickPosition(QSlider::TicksBelow);
     ledBrightnessSlider->setTickInterval(1);
 
+    connect(ledModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::updateLedPreview);
+    connect(ledSpeedSlider, &QSlider::valueChanged, this, &MainWindow::updateLedPreview);
+    connect(ledBrightnessSlider, &QSlider::valueChanged, this, &MainWindow::updateLedPreview);
+
     settingsLayout->addRow("mode:", ledModeCombo);
     settingsLayout->addRow("speed:", ledSpeedSlider);
     settingsLayout->addRow("brightness:", ledBrightnessSlider);
     settingsGroup->setLayout(settingsLayout);
     mainLedLayout->addWidget(settingsGroup);
 
+    QGroupBox *previewGroup = new QGroupBox("preview");
+    QVBoxLayout *previewLayout = new QVBoxLayout;
+    ledPreview = new LedPreview();
+    previewLayout->addWidget(ledPreview);
+    previewGroup->setLayout(previewLayout);
+    mainLedLayout->addWidget(previewGroup);
+
     ledColorGroup = new QGroupBox("color palette");
     QGridLayout* colorLayout = new QGridLayout;
     ledColorButtons.resize(7);
@@ -232,6 +338,11 @@ QWidget* MainWindow::LedTab() {
         colorLayout->addWidget(ledColorSwatches[i], i, 1);
         colorLayout->addWidget(ledColorButtons[i], i, 2);
     }
+
+    ledPaletteImageButton = new QPushButton("from image...");
+    connect(ledPaletteImageButton, &QPushButton::clicked, this, &MainWindow::selectPaletteFromImage);
+    colorLayout->addWidget(ledPaletteImageButton, 7, 0, 1, 3);
+
     ledColorGroup->setLayout(colorLayout);
     mainLedLayout->addWidget(ledColorGroup);
     mainLedLayout->addStretch();
@@ -330,7 +441,308 @@ void MainWindow::selectLedPaletteColor(int colorIndex) {
     if (color.isValid()) {
         palette.setColor(QPalette::Window, color);
         ledColorSwatches[colorIndex]->setPalette(palette);
+        updateLedPreview();
+    }
+}
+
+void MainWindow::selectPaletteFromImage() {
+    QString path = QFileDialog::getOpenFileName(this, "select image for palette", QString(),
+                                                "images (*.png *.jpg *.jpeg *.bmp *.webp *.gif);;all files (*)");
+    if (path.isEmpty()) return;
+
+    int modeId = ledModeCombo->currentData().toInt();
+    int color_count = ledModeColorCount.count(modeId) ? ledModeColorCount.at(modeId) : 0;
+    if (color_count == 0) return;
+
+    ledPaletteImageButton->setEnabled(false);
+    statusLabel->setText("extracting palette from image...");
+
+    // decoding and quantization go to worker thread, UI stays responsive
+    auto *watcher = new QFutureWatcher<vector<QColor>>(this);
+    connect(watcher, &QFutureWatcher<vector<QColor>>::finished, this, [this, watcher, path]() {
+        vector<QColor> colors = watcher->result();
+        watcher->deleteLater();
+        ledPaletteImageButton->setEnabled(true);
+
+        if (colors.empty()) {
+            statusLabel->setText("error: can't read image " + QFileInfo(path).fileName() + ".");
+            return;
+        }
+
+        for (size_t i = 0; i < colors.size() && i < ledColorSwatches.size(); ++i) {
+            QPalette palette = ledColorSwatches[i]->palette();
+            palette.setColor(QPalette::Window, colors[i]);
+            ledColorSwatches[i]->setPalette(palette);
+        }
+        updateLedPreview();
+        statusLabel->setText(QString("%1 colors taken from %2.").arg(colors.size()).arg(QFileInfo(path).fileName()));
+    });
+    watcher->setFuture(QtConcurrent::run([path, color_count]() {
+        return extractPaletteFromFile(path, color_count);
+    }));
+}
+
+void MainWindow::toggleMotionRecording() {
+    if (motionRecorder->isRecording()) {
+        motionRecorder->stop();
+        motionRecordTimer->stop();
+        motionRecordButton->setText("record...");
+        statusLabel->setText(QString("motion recording saved, %1 reports.").arg(motionRecorder->sampleCount()));
+        return;
+    }
+
+    string event_node = findEdgeEventNode(VID, PID);
+    if (event_node.empty()) {
+        statusLabel->setText("error: motion interface of the mouse not found. are you sure that mouse is connected?");
+        return;
+    }
+
+    // recording is labeled with what the mouse really runs, not with unsaved UI state
+    uint8_t sensor_perf = 0;
+    int poll_hz = 0;
+    if (!readSensorSettingsFromDevice(sensor_perf, poll_hz)) {
+        statusLabel->setText(statusLabel->text() + " can't record without knowing mouse settings.");
+        return;
+    }
+    QString suggested_name = QString("motion-%1hz-snap-%2-ripple-%3.edgemot")
+                                 .arg(poll_hz)
+                                 .arg((sensor_perf & 0x01) ? "on" : "off")
+                                 .arg((sensor_perf & 0x02) ? "on" : "off");
+
+    QString path = QFileDialog::getSaveFileName(this, "save motion recording", suggested_name,
+                                                "motion recordings (*.edgemot)");
+    if (path.isEmpty()) return;
+
+    string error;
+    if (!motionRecorder->start(event_node, path.toStdString(), sensor_perf, static_cast<uint16_t>(poll_hz), error)) {
+        statusLabel->setText("error: " + QString::fromStdString(error) + ". are you in 'input' group?");
+        return;
+    }
+
+    motionRecordButton->setText("stop");
+    motionRecordTimer->start();
+    statusLabel->setText("recording motion... move the mouse.");
+}
+
+void MainWindow::updateMotionRecordingStatus() {
+    if (!motionRecorder->isRecording()) {
+        // reader thread has stopped by itself
+        motionRecorder->stop();
+        motionRecordTimer->stop();
+        motionRecordButton->setText("record...");
+        statusLabel->setText(QString("error: motion recording interrupted after %1 reports. mouse disconnected or disk is full.")
+                                 .arg(motionRecorder->sampleCount()));
+        return;
+    }
+    statusLabel->setText(QString("recording motion... %1 reports.").arg(motionRecorder->sampleCount()));
+}
+
+void MainWindow::analyzeMotionRecordings() {
+    QStringList paths = QFileDialog::getOpenFileNames(this, "select motion recordings to compare", QString(),
+                                                      "motion recordings (*.edgemot)");
+    if (paths.isEmpty()) return;
+
+    motionAnalyzeButton->setEnabled(false);
+    statusLabel->setText("analyzing motion...");
+
+    auto *watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher]() {
+        QString report = watcher->result();
+        watcher->deleteLater();
+        motionAnalyzeButton->setEnabled(true);
+        statusLabel->setText("motion analysis done.");
+        QMessageBox::information(this, "motion analysis", report);
+    });
+    watcher->setFuture(QtConcurrent::run([paths]() {
+        return motionReportHtml(paths);
+    }));
+}
+
+void MainWindow::runLatencyMeasurement() {
+    string event_node = findEdgeEventNode(VID, PID);
+    string hidraw_node = event_node.empty() ? string() : findHidrawForEventNode(event_node);
+    if (hidraw_node.empty()) {
+        statusLabel->setText("error: motion interface of the mouse not found. are you sure that mouse is connected?");
+        return;
+    }
+
+    // capture is sized and labeled by the rate the mouse really runs, not by unsaved UI state
+    uint8_t sensor_perf = 0;
+    int poll_hz = 0;
+    if (!readSensorSettingsFromDevice(sensor_perf, poll_hz)) {
+        statusLabel->setText(statusLabel->text() + " can't measure without knowing polling rate of the mouse.");
+        return;
+    }
+
+    const int seconds = 10;
+    if (QMessageBox::information(this, "latency measurement",
+                                 QString("keep moving the mouse for %1 seconds after pressing OK.\n"
+                                         "mouse polls at %2 Hz.")
+                                     .arg(seconds).arg(poll_hz),
+                                 QMessageBox::Ok | QMessageBox::Cancel) != QMessageBox::Ok) {
+        return;
+    }
+
+    latencyButton->setEnabled(false);
+    statusLabel->setText(QString("measuring latency, keep moving the mouse... (%1 s)").arg(seconds));
+
+    auto *watcher = new QFutureWatcher<LatencyResult>(this);
+    connect(watcher, &QFutureWatcher<LatencyResult>::finished, this, [this, watcher, poll_hz]() {
+        LatencyResult r = watcher->result();
+        watcher->deleteLater();
+        latencyButton->setEnabled(true);
+
+        if (!r.error.empty()) {
+            statusLabel->setText("error: " + QString::fromStdString(r.error) + ".");
+            return;
+        }
+
+        auto row = [](const char* name, const LatencyPercentiles& p) {
+            return QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td></tr>")
+                .arg(name).arg(p.p50, 0, 'f', 0).arg(p.p99, 0, 'f', 0).arg(p.max, 0, 'f', 0);
+        };
+        QString html = QString("<p>%1 Hz, %2 pairs from %3 hidraw reports and %4 evdev frames.<br>"
+                               "unmatched: %5 hidraw reports, %6 evdev frames.<br>"
+                               "readers on CPU %7 and %8, %9.</p>")
+                           .arg(poll_hz).arg(r.matched).arg(r.hidrawReports).arg(r.evdevFrames)
+                           .arg(r.unmatchedHidraw).arg(r.unmatchedEvdev)
+                           .arg(r.hidrawCpu).arg(r.evdevCpu)
+                           .arg(r.realtime ? "SCHED_FIFO" : "no realtime priority (run with sudo for less noise)");
+        html += "<table cellpadding=3><tr><th>us</th><th>p50</th><th>p99</th><th>max</th></tr>";
+        html += row("evdev behind hidraw", r.evdevBehindHidraw);
+        html += row("hidraw delivery", r.hidrawDelivery);
+        html += row("evdev delivery", r.evdevDelivery);
+        html += "</table>";
+
+        statusLabel->setText(QString("latency measured: evdev is %1 us behind hidraw (p50), %2 us (p99).")
+                                 .arg(r.evdevBehindHidraw.p50, 0, 'f', 0).arg(r.evdevBehindHidraw.p99, 0, 'f', 0));
+        QMessageBox::information(this, "latency measurement", html);
+    });
+    watcher->setFuture(QtConcurrent::run([hidraw_node, event_node, poll_hz]() {
+        return measureInputLatency(hidraw_node, event_node, seconds, poll_hz);
+    }));
+}
+
+void MainWindow::runThroughputTest() {
+    QMessageBox confirm(QMessageBox::Warning, "device stress test",
+                        QString("stress test sends settings readbacks at rising rate and checks every answer, "
+                                "it takes up to a minute. don't touch the mouse meanwhile.\n\n"
+                                "write test additionally writes current settings onto the mouse up to %1 times, "
+                                "each with different LED brightness so dropped writes show up, LEDs will flicker. "
+                                "it's unknown whether firmware saves every write to flash memory, "
+                                "so write test may wear the flash out. include it only if you accept that risk.")
+                            .arg(MaxConfigWrites),
+                        QMessageBox::Cancel, this);
+    QPushButton *readsOnlyButton = confirm.addButton("readbacks only", QMessageBox::AcceptRole);
+    QPushButton *withWritesButton = confirm.addButton("include writes", QMessageBox::DestructiveRole);
+    confirm.setDefaultButton(readsOnlyButton);
+    confirm.exec();
+
+    bool test_writes = confirm.clickedButton() == withWritesButton;
+    if (!test_writes && confirm.clickedButton() != readsOnlyButton) return;
+
+    hid_device* dev = findAndOpenDevice();
+    if (!dev) return;
+    hid_close(dev);
+
+    updatePayloadFromUi();
+    string device_path = workingDevicePath;
+    vector<uint8_t> payload = currentPayloadState;
+
+    // nothing else may talk to the mouse while it is being stressed
+    setEnabled(false);
+    statusLabel->setText("stress testing the mouse...");
+
+    auto *watcher = new QFutureWatcher<ThroughputResult>(this);
+    throughputWatcher = watcher;
+    connect(watcher, &QFutureWatcher<ThroughputResult>::finished, this, [this, watcher]() {
+        ThroughputResult r = watcher->result();
+        watcher->deleteLater();
+        throughputWatcher = nullptr;
+        setEnabled(true);
+
+        if (!r.error.empty()) {
+            statusLabel->setText("error: stress test failed: " + QString::fromStdString(r.error) + ".");
+            return;
+        }
+
+        // readbacks-only run keeps write limits of the previous run
+        DeviceProfile profile = deviceProfile;
+        if (r.writesTested) {
+            profile.writesMeasured = true;
+            profile.maxWriteRate = r.maxWriteRate;
+            profile.writeErrorOnset = r.writeErrorOnset;
+            profile.writeRateLimit = r.writeRateLimit;
+            profile.writeP99Us = r.writeP99Us;
+        }
+        profile.readsMeasured = true;
+        profile.maxReadRate = r.maxReadRate;
+        profile.readErrorOnset = r.readErrorOnset;
+        profile.readRateLimit = r.readRateLimit;
+        profile.readP99Us = r.readP99Us;
+        profile.measuredAt = QDateTime::currentDateTime().toString(Qt::ISODate);
+        saveDeviceProfile(deviceKey, profile);
+        deviceProfile = profile;
+
+        auto rows = [](const char* name, const vector<RateStep>& steps) {
+            QString html;
+            for (const RateStep& step : steps) {
+                html += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4/%5</td><td>%6</td><td>%7</td><td>%8</td><td>%9</td></tr>")
+                            .arg(name).arg(step.offeredRate).arg(step.achievedRate, 0, 'f', 1)
+                            .arg(step.verified).arg(step.sent).arg(step.errors)
+                            .arg(step.p50Us, 0, 'f', 0).arg(step.p99Us, 0, 'f', 0).arg(step.maxUs, 0, 'f', 0);
+            }
+            return html;
+        };
+        QString html = QString("<p>max clean rate: writes %1, readbacks %2/s.<br>"
+                               "errors start at: writes %3, readbacks %4.</p>")
+                           .arg(r.writesTested ? QString("%1/s").arg(r.maxWriteRate) : QString("not tested"))
+                           .arg(r.maxReadRate)
+                           .arg(r.writeErrorOnset > 0 ? QString("%1/s").arg(r.writeErrorOnset) : QString("-"))
+                           .arg(r.readErrorOnset > 0 ? QString("%1/s").arg(r.readErrorOnset) : QString("-"));
+        html += "<table cellpadding=3><tr><th></th><th>offered/s</th><th>achieved/s</th><th>verified</th>"
+                "<th>errors</th><th>p50 us</th><th>p99 us</th><th>max us</th></tr>";
+        html += rows("write", r.writeSteps);
+        html += rows("read", r.readSteps);
+        html += "</table>";
+
+        statusLabel->setText(QString("stress test done, profile saved: writes paced by %1, readbacks by %2/s.")
+                                 .arg(profile.writesMeasured ? QString("%1/s").arg(profile.writeRateLimit) : QString("nothing (not tested)"))
+                                 .arg(profile.readRateLimit));
+        QMessageBox::information(this, "device stress test", html);
+    });
+    watcher->setFuture(QtConcurrent::run([device_path, payload, test_writes]() {
+        return characterizeThroughput(device_path, payload, test_writes);
+    }));
+}
+
+void MainWindow::throttleDeviceRequest(double rateLimit) {
+    // keeping at half of the rate limit stress test found
+    if (rateLimit > 0 && lastDeviceRequest.isValid()) {
+        qint64 min_interval_us = qint64(2e6 / rateLimit);
+        qint64 passed_us = lastDeviceRequest.nsecsElapsed() / 1000;
+        if (passed_us < min_interval_us) {
+            QThread::usleep(static_cast<unsigned long>(min_interval_us - passed_us));
+        }
+    }
+    lastDeviceRequest.restart();
+}
+
+void MainWindow::updateLedPreview() {
+    int modeId = ledModeCombo->currentData().toInt();
+
+    int color_count = 0;
+    if (ledModeColorCount.count(modeId)) {
+        color_count = ledModeColorCount.at(modeId);
     }
+
+    // preview uses only colors that this mode really sends to the mouse
+    vector<QColor> palette;
+    for (int i = 0; i < color_count; ++i) {
+        palette.push_back(ledColorSwatches[i]->palette().color(QPalette::Window));
+    }
+
+    ledPreview->setParameters(modeId, ledSpeedSlider->value(), ledBrightnessSlider->value(), palette);
 }
 
 hid_device* MainWindow::findAndOpenDevice()
@@ -356,6 +768,7 @@ hid_device* MainWindow::findAndOpenDevice()
         hid_device* dev = hid_open_path(cur_dev->path);
         if (!dev) continue;
 
+        // probe is neither a command stress test measured nor sent to measured interface, so it isn't paced
         if (hid_write(dev, test_cmd.data(), test_cmd.size()) < 0) {
             hid_close(dev);
             continue;
@@ -368,6 +781,8 @@ hid_device* MainWindow::findAndOpenDevice()
             vector<uint8_t> expected_response = {0x04, 0xa0, 0x01, 0x00, 0x00, 0x0a, 0x23};
             if (memcmp(read_buf.data(), expected_response.data(), expected_response.size()) == 0) {
                 workingDevicePath = cur_dev->path;
+                deviceKey = deviceProfileKey(VID, PID, cur_dev->serial_number ? QString::fromWCharArray(cur_dev->serial_number) : QString());
+                deviceProfile = loadDeviceProfile(deviceKey);
                 opened_device = dev;
                 break;
             }
@@ -390,6 +805,7 @@ vector<uint8_t> MainWindow::readHidReport()
     vector<uint8_t> cmd_read = {ReportID, 0xa0, 0x01, 0x01};
     cmd_read.resize(ReportBufferLength, 0);
 
+    throttleDeviceRequest(deviceProfile.readRateLimit);
     if (hid_write(dev, cmd_read.data(), cmd_read.size()) < 0) {
         statusLabel->setText(QString("sending read command error: %1").arg(QString::fromWCharArray(hid_error(dev))));
         hid_close(dev);
@@ -424,6 +840,28 @@ vector<uint8_t> MainWindow::readHidReport()
     return payload;
 }
 
+bool MainWindow::readSensorSettingsFromDevice(uint8_t& sensorPerf, int& pollHz)
+{
+    vector<uint8_t> readback = readHidReport();
+    if (readback.empty()) return false; // status is already set
+
+    if (readback.size() <= MagicByteB - ReadbackShift
+        || readback[MagicByteA - ReadbackShift] != 0xa5 || readback[MagicByteB - ReadbackShift] != 0xa5) {
+        statusLabel->setText("error: unexpected layout of settings read from mouse.");
+        return false;
+    }
+
+    int poll_index = readback[PollingRate - ReadbackShift];
+    if (!pollingRateMapToHz.count(poll_index)) {
+        statusLabel->setText("error: unknown polling rate read from mouse.");
+        return false;
+    }
+
+    sensorPerf = readback[SensorPerf - ReadbackShift];
+    pollHz = pollingRateMapToHz.at(poll_index);
+    return true;
+}
+
 bool MainWindow::sendHidReport(const vector<uint8_t>& payload_data)
 {
     if (payload_data.size() != WritePayloadLength) {
@@ -437,6 +875,7 @@ bool MainWindow::sendHidReport(const vector<uint8_t>& payload_data)
     vector<uint8_t> report_buffer = {ReportID};
     report_buffer.insert(report_buffer.end(), payload_data.begin(), payload_data.end());
 
+    throttleDeviceRequest(deviceProfile.writeRateLimit);
     int bytes_written = hid_write(dev, report_buffer.data(), report_buffer.size());
     hid_close(dev);
 
@@ -519,6 +958,7 @@ void MainWindow::updateUiFromPayload(const vector<uint8_t>& payload)
     }
 
     updateColorPickersVisibility(ledModeCombo->currentIndex());
+    updateLedPreview();
 }
 
 void MainWindow::updatePayloadFromUi()
@@ -2,10 +2,13 @@
 #define MAINWINDOW_H
 
 #include <QWidget>
+#include <QElapsedTimer>
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include "hidapi/hidapi.h"
+#include "deviceprofile.h"
 
 // Прямые объявления классов Qt для уменьшения времени компиляции
 class QLabel;
@@ -15,6 +18,11 @@ class QCheckBox;
 class QSlider;
 class QSpinBox;
 class QGroupBox;
+class QTimer;
+class QCloseEvent;
+class QFutureWatcherBase;
+class LedPreview;
+class MotionRecorder;
 
 class MainWindow : public QWidget
 {
@@ -24,12 +32,22 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
 private slots:
     void writeToDevice();
     void restoreDefaults();
     void selectLedColor();
     void updateColorPickersVisibility(int index);
     void selectLedPaletteColor(int colorIndex);
+    void updateLedPreview();
+    void selectPaletteFromImage();
+    void toggleMotionRecording();
+    void updateMotionRecordingStatus();
+    void analyzeMotionRecordings();
+    void runLatencyMeasurement();
+    void runThroughputTest();
 
 private:
     // UI
@@ -46,6 +64,12 @@ private:
     QCheckBox* angleSnapCheck;
     QCheckBox* rippleControlCheck;
     QSpinBox* activeDpiSpinBox;
+    QPushButton* motionRecordButton;
+    QPushButton* motionAnalyzeButton;
+    QPushButton* latencyButton;
+    QTimer* motionRecordTimer;
+    std::unique_ptr<MotionRecorder> motionRecorder;
+    QFutureWatcherBase* throughputWatcher = nullptr;   // set while stress test runs
 
     // LED
     QComboBox* ledModeCombo;
@@ -56,6 +80,8 @@ private:
     QGroupBox* ledColorGroup; // Группа, объединяющая все селекторы цвета
     std::vector<QPushButton*> ledColorButtons; // 7 кнопок "Select..."
     std::vector<QLabel*> ledColorSwatches;      // 7 "образцов" цвета
+    QPushButton* ledPaletteImageButton;
+    LedPreview* ledPreview;
 
     // DPI editor
     std::vector<QCheckBox*> dpiEnableChecks;
@@ -69,11 +95,18 @@ private:
     hid_device* findAndOpenDevice();
     bool sendHidReport(const std::vector<uint8_t>& payload);
     std::vector<uint8_t> readHidReport();
+    bool readSensorSettingsFromDevice(uint8_t& sensorPerf, int& pollHz);
     std::vector<uint8_t> factorySettingsPayload();
+    void throttleDeviceRequest(double rateLimit);
 
     std::vector<uint8_t> currentPayloadState;
     std::string workingDevicePath;
 
+    // measured limits of the connected mouse, readbacks and writes to it are spaced according to them
+    QString deviceKey;
+    DeviceProfile deviceProfile;
+    QElapsedTimer lastDeviceRequest;
+
     // conversion maps
     std::map<std::string, int> ledModeIDs;
     std::map<int, uint8_t> ledModeSpeedMap;
@@ -101,6 +134,12 @@ private:
     static const size_t LEDBrightness = 38;
     static const size_t LEDPaletteFlag = 40;
     static const size_t DPIColorsStart = 41;
+
+    // readback payload mirrors write payload without its first 4 bytes,
+    // magic bytes at 5 and 35 confirm that
+    static const size_t ReadbackShift = 4;
+    static const size_t MagicByteA = 5;
+    static const size_t MagicByteB = 35;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "motionanalyzer.h"
+
+using namespace std;
+
+namespace {
+
+const int64_t StrokeGapUs = 50000;      // pause which ends a stroke
+const size_t MinStrokeSamples = 16;
+const float MinStrokeLength = 50;       // counts, shorter strokes are mostly clicks and noise
+const int WindowSize = 64;
+const int WindowHop = WindowSize / 2;
+
+#ifdef __SSE2__
+float horizontalSum(__m128 v) {
+    float lanes[4];
+    _mm_storeu_ps(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
+// geometry of single reports against stroke direction (ux, uy):
+// lateral[i] is signed step across the stroke line,
+// pathLength is sum of step lengths, sinSquared is sum of length * sin^2 of step angle
+void stepKernel(const float* dx, const float* dy, size_t n, float ux, float uy,
+                float* lateral, double& pathLength, double& sinSquared)
+{
+    size_t i = 0;
+    float length_sum = 0, sin_sum = 0;
+#ifdef __SSE2__
+    const __m128 vux = _mm_set1_ps(ux), vuy = _mm_set1_ps(uy), tiny = _mm_set1_ps(1e-6f);
+    __m128 length_acc = _mm_setzero_ps(), sin_acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(dx + i);
+        __m128 y = _mm_loadu_ps(dy + i);
+        __m128 cross = _mm_sub_ps(_mm_mul_ps(x, vuy), _mm_mul_ps(y, vux));
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        _mm_storeu_ps(lateral + i, cross);
+        length_acc = _mm_add_ps(length_acc, length);
+        sin_acc = _mm_add_ps(sin_acc, _mm_div_ps(_mm_mul_ps(cross, cross), _mm_max_ps(length, tiny)));
+    }
+    length_sum = horizontalSum(length_acc);
+    sin_sum = horizontalSum(sin_acc);
+#endif
+    for (; i < n; ++i) {
+        float cross = dx[i] * uy - dy[i] * ux;
+        float length = sqrt(dx[i] * dx[i] + dy[i] * dy[i]);
+        lateral[i] = cross;
+        length_sum += length;
+        sin_sum += cross * cross / max(length, 1e-6f);
+    }
+    pathLength = length_sum;
+    sinSquared = sin_sum;
+}
+
+// out = (in - mean) * window, n is multiple of 4
+void windowKernel(const float* in, const float* window, float mean, float* out, size_t n)
+{
+#ifdef __SSE2__
+    const __m128 vmean = _mm_set1_ps(mean);
+    for (size_t i = 0; i < n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(in + i), vmean), _mm_loadu_ps(window + i)));
+    }
+#else
+    for (size_t i = 0; i < n; ++i) out[i] = (in[i] - mean) * window[i];
+#endif
+}
+
+// radix-2 FFT of fixed size with precomputed twiddles and bit reversal
+class Fft {
+public:
+    explicit Fft(int size) : size(size), twiddles(size / 2), reversed(size) {
+        for (int k = 0; k < size / 2; ++k) twiddles[k] = polar(1.0f, float(-2 * M_PI * k / size));
+        int bits = 0;
+        while ((1 << bits) < size) ++bits;
+        for (int i = 0; i < size; ++i) {
+            int r = 0;
+            for (int b = 0; b < bits; ++b) if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+            reversed[i] = r;
+        }
+    }
+
+    void powerSpectrum(const float* input, vector<double>& power) {
+        vector<complex<float>>& a = buffer;
+        a.resize(size);
+        for (int i = 0; i < size; ++i) a[reversed[i]] = input[i];
+
+        for (int length = 2; length <= size; length <<= 1) {
+            int step = size / length;
+            for (int start = 0; start < size; start += length) {
+                for (int j = 0; j < length / 2; ++j) {
+                    complex<float> t = twiddles[j * step] * a[start + j + length / 2];
+                    a[start + j + length / 2] = a[start + j] - t;
+                    a[start + j] += t;
+                }
+            }
+        }
+        for (int k = 0; k <= size / 2; ++k) power[k] += norm(a[k]);
+    }
+
+private:
+    int size;
+    vector<complex<float>> twiddles;
+    vector<int> reversed;
+    vector<complex<float>> buffer;
+};
+
+}
+
+MotionAnalysis analyzeMotion(const MotionRecording& recording)
+{
+    MotionAnalysis result;
+    const size_t n = recording.timestamps.size();
+    result.samples = n;
+    if (n < 2) return result;
+
+    const vector<int64_t>& t = recording.timestamps;
+    result.durationSeconds = (t.back() - t.front()) / 1e6;
+
+    vector<float> fx(recording.dx.begin(), recording.dx.end());
+    vector<float> fy(recording.dy.begin(), recording.dy.end());
+    vector<float> lateral(n);
+
+    vector<int64_t> intervals;
+    intervals.reserve(n);
+    for (size_t i = 1; i < n; ++i) {
+        int64_t dt = t[i] - t[i - 1];
+        if (dt > 0 && dt <= StrokeGapUs) intervals.push_back(dt);
+    }
+    if (!intervals.empty()) {
+        nth_element(intervals.begin(), intervals.begin() + intervals.size() / 2, intervals.end());
+        result.sampleRateHz = 1e6 / intervals[intervals.size() / 2];
+    }
+
+    vector<float> hann(WindowSize);
+    for (int i = 0; i < WindowSize; ++i) hann[i] = float(0.5 - 0.5 * cos(2 * M_PI * i / (WindowSize - 1)));
+    vector<float> windowed(WindowSize);
+    vector<double> power(WindowSize / 2 + 1, 0.0);
+    Fft fft(WindowSize);
+
+    double total_chord = 0, total_path = 0, total_sin = 0;
+    double offset_squares = 0;
+    size_t offset_count = 0;
+
+    size_t begin = 0;
+    while (begin < n) {
+        size_t end = begin + 1;
+        while (end < n && t[end] - t[end - 1] <= StrokeGapUs) ++end;
+        const size_t count = end - begin;
+
+        double sx = 0, sy = 0;
+        for (size_t i = begin; i < end; ++i) { sx += fx[i]; sy += fy[i]; }
+        double chord = hypot(sx, sy);
+
+        if (count >= MinStrokeSamples && chord >= MinStrokeLength) {
+            ++result.strokes;
+
+            double path, sin_squared;
+            stepKernel(&fx[begin], &fy[begin], count, float(sx / chord), float(sy / chord),
+                       &lateral[begin], path, sin_squared);
+            total_chord += chord;
+            total_path += path;
+            total_sin += sin_squared;
+
+            // distance from the line between stroke start and end
+            float position = 0;
+            for (size_t i = 0; i < count; ++i) {
+                position += lateral[begin + i];
+                offset_squares += double(position) * position;
+            }
+            offset_count += count;
+
+            // spectrum of per-report lateral steps, sensor noise and ripple filtering show up there
+            for (size_t start = 0; start + WindowSize <= count; start += WindowHop) {
+                const float* steps = &lateral[begin + start];
+                float mean = 0;
+                for (int i = 0; i < WindowSize; ++i) mean += steps[i];
+                mean /= WindowSize;
+                windowKernel(steps, hann.data(), mean, windowed.data(), WindowSize);
+                fft.powerSpectrum(windowed.data(), power);
+            }
+        }
+        begin = end;
+    }
+
+    if (total_path > 0) {
+        result.straightness = total_chord / total_path;
+        result.angularDeviationDeg = asin(sqrt(min(1.0, total_sin / total_path))) * 180.0 / M_PI;
+    }
+    if (offset_count > 0) result.lateralJitterRms = sqrt(offset_squares / offset_count);
+
+    // DC bin is dropped, it is just the stroke curvature
+    double band_total = 0;
+    int peak_bin = 0;
+    for (int k = 1; k <= WindowSize / 2; ++k) {
+        int band = min(2, (3 * k - 1) / (WindowSize / 2));
+        result.jitterBands[band] += power[k];
+        band_total += power[k];
+        if (peak_bin == 0 || power[k] > power[peak_bin]) peak_bin = k;
+    }
+    if (band_total > 0) {
+        for (double& share : result.jitterBands) share /= band_total;
+        result.jitterPeakHz = peak_bin * result.sampleRateHz / WindowSize;
+    }
+    return result;
+}
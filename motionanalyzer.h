@@ -0,0 +1,27 @@
+#ifndef MOTIONANALYZER_H
+#define MOTIONANALYZER_H
+
+#include <cstddef>
+#include "motionrecorder.h"
+
+// metrics for comparing angle snap / ripple control on and off.
+// recording is split into strokes by pauses, every stroke is compared with straight line
+// from its start to its end
+struct MotionAnalysis {
+    size_t samples = 0;
+    size_t strokes = 0;               // strokes long enough to be analyzed
+    double durationSeconds = 0;
+    double sampleRateHz = 0;          // from median report interval
+
+    double straightness = 0;          // chord / path length over all strokes, 1.0 - perfectly straight
+    double angularDeviationDeg = 0;   // rms angle between single reports and stroke direction
+    double lateralJitterRms = 0;      // rms distance from stroke line, counts
+
+    // spectrum of lateral steps between reports (welch, 64-sample hann windows)
+    double jitterPeakHz = 0;
+    double jitterBands[3] = {};       // share of power in low/mid/high third of nyquist
+};
+
+MotionAnalysis analyzeMotion(const MotionRecording& recording);
+
+#endif // MOTIONANALYZER_H
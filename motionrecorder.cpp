@@ -0,0 +1,195 @@
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include "motionrecorder.h"
+#include "edgeinput.h"
+
+using namespace std;
+
+namespace {
+
+const char Magic[8] = {'E', 'D', 'G', 'E', 'M', 'O', 'T', '1'};
+const size_t HeaderLength = sizeof(Magic) + 1 + 2;
+const size_t FlushThreshold = 64 * 1024;
+
+void putVarint(vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+// small negative deltas must stay small after encoding
+uint64_t zigzag(int64_t value) {
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+bool getVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7) {
+        uint8_t byte = *data++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+}
+
+bool loadMotionRecording(const string& path, MotionRecording& recording, string& error)
+{
+    ifstream file(path, ios::binary);
+    if (!file) {
+        error = "can't open " + path;
+        return false;
+    }
+    vector<uint8_t> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    if (data.size() < HeaderLength || memcmp(data.data(), Magic, sizeof(Magic)) != 0) {
+        error = path + " is not a motion recording";
+        return false;
+    }
+
+    recording = MotionRecording();
+    recording.sensorPerf = data[8];
+    recording.pollRateHz = uint16_t(data[9] | (data[10] << 8));
+
+    // records are at least 3 bytes
+    size_t estimate = (data.size() - HeaderLength) / 3;
+    recording.timestamps.reserve(estimate);
+    recording.dx.reserve(estimate);
+    recording.dy.reserve(estimate);
+
+    const uint8_t* cursor = data.data() + HeaderLength;
+    const uint8_t* end = data.data() + data.size();
+    int64_t time = 0;
+    while (cursor < end) {
+        uint64_t dt, dx, dy;
+        // recording which was interrupted mid-record just loses its last sample
+        if (!getVarint(cursor, end, dt) || !getVarint(cursor, end, dx) || !getVarint(cursor, end, dy)) break;
+        time += int64_t(dt);
+        recording.timestamps.push_back(time);
+        recording.dx.push_back(int32_t(unzigzag(dx)));
+        recording.dy.push_back(int32_t(unzigzag(dy)));
+    }
+    return true;
+}
+
+MotionRecorder::~MotionRecorder()
+{
+    stop();
+}
+
+bool MotionRecorder::start(const string& eventNode, const string& path,
+                           uint8_t sensorPerf, uint16_t pollRateHz, string& error)
+{
+    stop();
+
+    int fd = open(eventNode.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        error = "can't open " + eventNode + ": " + strerror(errno);
+        return false;
+    }
+
+    // default evdev clock is realtime, which jumps with NTP
+    int clock_id = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clock_id);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "can't create " + path + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    vector<uint8_t> header(Magic, Magic + sizeof(Magic));
+    header.push_back(sensorPerf);
+    header.push_back(uint8_t(pollRateHz & 0xff));
+    header.push_back(uint8_t(pollRateHz >> 8));
+    fwrite(header.data(), 1, header.size(), file);
+
+    samples = 0;
+    running = true;
+    worker = thread(&MotionRecorder::readLoop, this, fd, file);
+    return true;
+}
+
+void MotionRecorder::stop()
+{
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void MotionRecorder::readLoop(int fd, FILE* file)
+{
+    vector<uint8_t> buffer;
+    buffer.reserve(FlushThreshold + 64);
+
+    input_event events[64];
+    int64_t previous_time = 0;
+    int32_t dx = 0, dy = 0;
+    bool dropping = false;
+
+    while (running) {
+        pollfd pfd = {fd, POLLIN, 0};
+        // timeout only to notice stop() request
+        if (poll(&pfd, 1, 100) <= 0) continue;
+
+        ssize_t bytes = read(fd, events, sizeof(events));
+        if (bytes < 0) {
+            if (errno == EAGAIN || errno == EINTR) continue;
+            break; // ENODEV - mouse is gone
+        }
+
+        for (size_t i = 0; i < size_t(bytes) / sizeof(input_event); ++i) {
+            const input_event& ev = events[i];
+            if (dropping) {
+                // everything up to and including next SYN_REPORT belongs to broken frame
+                if (ev.type == EV_SYN && ev.code == SYN_REPORT) dropping = false;
+                continue;
+            }
+
+            if (ev.type == EV_REL) {
+                if (ev.code == REL_X) dx += ev.value;
+                else if (ev.code == REL_Y) dy += ev.value;
+            } else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+                if (dx == 0 && dy == 0) continue; // button-only report
+
+                int64_t time = eventMicroseconds(ev);
+                putVarint(buffer, uint64_t(max<int64_t>(time - previous_time, 0)));
+                putVarint(buffer, zigzag(dx));
+                putVarint(buffer, zigzag(dy));
+                previous_time = time;
+                dx = dy = 0;
+                ++samples;
+            } else if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+                // kernel buffer overflowed, partial frame is meaningless
+                dx = dy = 0;
+                dropping = true;
+            }
+        }
+
+        if (buffer.size() >= FlushThreshold) {
+            if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) break;
+            buffer.clear();
+        }
+    }
+
+    fwrite(buffer.data(), 1, buffer.size(), file);
+    fclose(file);
+    close(fd);
+    running = false;
+}
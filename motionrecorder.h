@@ -0,0 +1,58 @@
+#ifndef MOTIONRECORDER_H
+#define MOTIONRECORDER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+
+// motion recording file (.edgemot), all numbers little-endian:
+//   "EDGEMOT1"         magic
+//   u8                 SensorPerf byte at recording time (bit 0 - angle snap, bit 1 - ripple)
+//   u16                polling rate, Hz
+//   then one record per motion report:
+//   varint             time since previous report, us (first one - since monotonic clock start)
+//   zigzag varint      dx
+//   zigzag varint      dy
+// typical record is 3-4 bytes, so hour at 1000 Hz is about 14 MB
+
+struct MotionRecording {
+    uint8_t sensorPerf = 0;
+    uint16_t pollRateHz = 0;
+    std::vector<int64_t> timestamps; // us
+    std::vector<int32_t> dx;
+    std::vector<int32_t> dy;
+};
+
+bool loadMotionRecording(const std::string& path, MotionRecording& recording, std::string& error);
+
+// records evdev motion frames of the mouse on its own thread.
+// one SYN_REPORT frame corresponds to one HID report from the mouse
+class MotionRecorder
+{
+public:
+    MotionRecorder() = default;
+    ~MotionRecorder();
+
+    MotionRecorder(const MotionRecorder&) = delete;
+    MotionRecorder& operator=(const MotionRecorder&) = delete;
+
+    bool start(const std::string& eventNode, const std::string& path,
+               uint8_t sensorPerf, uint16_t pollRateHz, std::string& error);
+    void stop();
+
+    // false also when reader has stopped by itself (mouse unplugged, disk full)
+    bool isRecording() const { return running; }
+    uint64_t sampleCount() const { return samples; }
+
+private:
+    void readLoop(int fd, FILE* file);
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> samples{0};
+};
+
+#endif // MOTIONRECORDER_H
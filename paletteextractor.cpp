@@ -0,0 +1,191 @@
+#include <QImageReader>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cfloat>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "paletteextractor.h"
+
+using namespace std;
+
+namespace {
+
+const int MaxColors = 7;
+const int MaxIterations = 24;
+const int MaxSampleSide = 256;          // 4K picture is quantized through at most 256x256 points
+const float ConvergenceShift = 0.25f;   // squared center movement in 0..255 color space
+
+// colors in SoA layout, padded to a multiple of 4 so SIMD loop needs no tail
+struct Samples {
+    vector<float> r, g, b;
+    size_t count = 0;
+};
+
+struct Centers {
+    float r[MaxColors], g[MaxColors], b[MaxColors];
+    int k = 0;
+};
+
+// nearest center for every sample, plus squared distance to it
+void assignClusters(const Samples& s, const Centers& c, vector<int32_t>& labels, vector<float>& distances)
+{
+    const size_t padded = s.r.size();
+#ifdef __SSE2__
+    for (size_t i = 0; i < padded; i += 4) {
+        __m128 r = _mm_loadu_ps(&s.r[i]);
+        __m128 g = _mm_loadu_ps(&s.g[i]);
+        __m128 b = _mm_loadu_ps(&s.b[i]);
+        __m128 best = _mm_set1_ps(FLT_MAX);
+        __m128i best_label = _mm_setzero_si128();
+
+        for (int j = 0; j < c.k; ++j) {
+            __m128 dr = _mm_sub_ps(r, _mm_set1_ps(c.r[j]));
+            __m128 dg = _mm_sub_ps(g, _mm_set1_ps(c.g[j]));
+            __m128 db = _mm_sub_ps(b, _mm_set1_ps(c.b[j]));
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+
+            __m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, best));
+            best = _mm_min_ps(d, best);
+            best_label = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(j)), _mm_andnot_si128(closer, best_label));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&labels[i]), best_label);
+        _mm_storeu_ps(&distances[i], best);
+    }
+#else
+    for (size_t i = 0; i < padded; ++i) {
+        float best = FLT_MAX;
+        int32_t best_label = 0;
+        for (int j = 0; j < c.k; ++j) {
+            float dr = s.r[i] - c.r[j], dg = s.g[i] - c.g[j], db = s.b[i] - c.b[j];
+            float d = dr * dr + dg * dg + db * db;
+            if (d < best) { best = d; best_label = j; }
+        }
+        labels[i] = best_label;
+        distances[i] = best;
+    }
+#endif
+}
+
+// k-means++ seeding with fixed seed, so the same picture always gives the same palette
+void seedCenters(const Samples& s, int k, Centers& c, vector<int32_t>& labels, vector<float>& distances)
+{
+    mt19937 rng(0xed9e);
+    size_t first = uniform_int_distribution<size_t>(0, s.count - 1)(rng);
+    c.r[0] = s.r[first]; c.g[0] = s.g[first]; c.b[0] = s.b[first];
+    c.k = 1;
+
+    while (c.k < k) {
+        assignClusters(s, c, labels, distances);
+        double total = accumulate(distances.begin(), distances.begin() + s.count, 0.0);
+
+        size_t pick = 0;
+        if (total > 0) {
+            double target = uniform_real_distribution<double>(0, total)(rng);
+            for (; pick + 1 < s.count; ++pick) {
+                target -= distances[pick];
+                if (target <= 0) break;
+            }
+        }
+        c.r[c.k] = s.r[pick]; c.g[c.k] = s.g[pick]; c.b[c.k] = s.b[pick];
+        ++c.k;
+    }
+}
+
+Samples sampleImage(const QImage& image)
+{
+    QImage small = image;
+    if (small.width() > MaxSampleSide || small.height() > MaxSampleSide) {
+        small = small.scaled(MaxSampleSide, MaxSampleSide, Qt::KeepAspectRatio, Qt::FastTransformation);
+    }
+    small = small.convertToFormat(QImage::Format_ARGB32);
+
+    Samples s;
+    const size_t capacity = size_t(small.width()) * small.height() + 3;
+    s.r.reserve(capacity); s.g.reserve(capacity); s.b.reserve(capacity);
+
+    for (int y = 0; y < small.height(); ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(small.constScanLine(y));
+        for (int x = 0; x < small.width(); ++x) {
+            // transparent areas of icons/artwork should not become a palette color
+            if (qAlpha(line[x]) < 128) continue;
+            s.r.push_back(qRed(line[x]));
+            s.g.push_back(qGreen(line[x]));
+            s.b.push_back(qBlue(line[x]));
+        }
+    }
+    s.count = s.r.size();
+
+    while (s.count > 0 && s.r.size() % 4 != 0) {
+        s.r.push_back(s.r.back()); s.g.push_back(s.g.back()); s.b.push_back(s.b.back());
+    }
+    return s;
+}
+
+}
+
+vector<QColor> extractPalette(const QImage& image, int colorCount)
+{
+    if (image.isNull()) return {};
+
+    Samples s = sampleImage(image);
+    if (s.count == 0) return {};
+
+    const int k = int(min<size_t>(clamp(colorCount, 1, MaxColors), s.count));
+    vector<int32_t> labels(s.r.size());
+    vector<float> distances(s.r.size());
+
+    Centers c;
+    seedCenters(s, k, c, labels, distances);
+
+    vector<int> counts(k);
+    for (int iteration = 0; iteration < MaxIterations; ++iteration) {
+        assignClusters(s, c, labels, distances);
+
+        double sum_r[MaxColors] = {}, sum_g[MaxColors] = {}, sum_b[MaxColors] = {};
+        fill(counts.begin(), counts.end(), 0);
+        for (size_t i = 0; i < s.count; ++i) {
+            int label = labels[i];
+            sum_r[label] += s.r[i];
+            sum_g[label] += s.g[i];
+            sum_b[label] += s.b[i];
+            ++counts[label];
+        }
+
+        float max_shift = 0;
+        for (int j = 0; j < k; ++j) {
+            if (counts[j] == 0) continue; // center stays where it was
+            float r = float(sum_r[j] / counts[j]), g = float(sum_g[j] / counts[j]), b = float(sum_b[j] / counts[j]);
+            float dr = r - c.r[j], dg = g - c.g[j], db = b - c.b[j];
+            max_shift = max(max_shift, dr * dr + dg * dg + db * db);
+            c.r[j] = r; c.g[j] = g; c.b[j] = b;
+        }
+        if (max_shift < ConvergenceShift) break;
+    }
+
+    vector<int> order(k);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&counts](int a, int b) { return counts[a] > counts[b]; });
+
+    vector<QColor> palette;
+    for (int j : order) {
+        if (counts[j] == 0) continue;
+        palette.push_back(QColor(qRound(c.r[j]), qRound(c.g[j]), qRound(c.b[j])));
+    }
+    return palette;
+}
+
+vector<QColor> extractPaletteFromFile(const QString& path, int colorCount)
+{
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+
+    QSize size = reader.size();
+    if (size.isValid() && (size.width() > MaxSampleSide || size.height() > MaxSampleSide)) {
+        reader.setScaledSize(size.scaled(MaxSampleSide, MaxSampleSide, Qt::KeepAspectRatio));
+    }
+
+    return extractPalette(reader.read(), colorCount);
+}
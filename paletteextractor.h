@@ -0,0 +1,19 @@
+#ifndef PALETTEEXTRACTOR_H
+#define PALETTEEXTRACTOR_H
+
+#include <QColor>
+#include <QImage>
+#include <QString>
+#include <vector>
+
+// k-means color quantization for "palette from image".
+// both functions are blocking and safe to call from worker thread.
+// colors are sorted by how much of the image they cover, most common first
+
+std::vector<QColor> extractPalette(const QImage& image, int colorCount);
+
+// decodes image already downscaled where the format allows it (jpeg), so 4K pictures stay cheap.
+// returns empty vector if file can't be read
+std::vector<QColor> extractPaletteFromFile(const QString& path, int colorCount);
+
+#endif // PALETTEEXTRACTOR_H
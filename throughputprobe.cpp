@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include "hidapi/hidapi.h"
+#include "throughputprobe.h"
+#include "edgeinput.h"
+
+using namespace std;
+
+namespace {
+
+const uint8_t ReportID = 0x04;
+const size_t ReportBufferLength = 64;
+const double Rates[] = {5, 10, 20, 50, 100, 200, 500, 1000};
+const double StepSeconds = 2.0;
+const size_t MinStepRequests = 20;
+const size_t WriteStepRequests = 36;   // fixed, so the whole write ramp fits MaxConfigWrites
+const size_t WritesPerReadback = 6;    // every 6th write is checked by readback in the middle of the step
+// writes differ only in LED brightness (0..10), so a dropped write leaves previous value behind
+const size_t LEDBrightness = 38;
+const size_t ReadbackShift = 4;
+const uint8_t BrightnessLevels = 11;
+const int DrainTimeoutMs = 500;
+const double MinAchievedShare = 0.95;   // below that device is saturated even without errors
+
+void sleepUntil(int64_t us) {
+    timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+}
+
+bool isReadbackHeader(const uint8_t* packet) {
+    static const uint8_t header[] = {0x04, 0xa0, 0x01, 0x01, 0x01};
+    return memcmp(packet, header, sizeof(header)) == 0;
+}
+
+// reads and throws away everything until device is quiet for timeout
+void drain(hid_device* dev, int timeoutMs) {
+    uint8_t buf[ReportBufferLength];
+    while (hid_read_timeout(dev, buf, sizeof(buf), timeoutMs) > 0) {}
+}
+
+// closed-loop readback, two packets like MainWindow::readHidReport
+bool readConfig(hid_device* writer, hid_device* reader, vector<uint8_t>& payload) {
+    vector<uint8_t> cmd = {ReportID, 0xa0, 0x01, 0x01};
+    cmd.resize(ReportBufferLength, 0);
+    if (hid_write(writer, cmd.data(), cmd.size()) < 0) return false;
+
+    uint8_t first[ReportBufferLength] = {}, second[ReportBufferLength] = {};
+    if (hid_read_timeout(reader, first, sizeof(first), 1000) <= 0) return false;
+    if (hid_read_timeout(reader, second, sizeof(second), 1000) <= 0) return false;
+    if (!isReadbackHeader(first)) return false;
+
+    payload.assign(first + 5, first + ReportBufferLength);
+    payload.insert(payload.end(), second + 5, second + ReportBufferLength);
+    return true;
+}
+
+void fillPercentiles(RateStep& step, vector<double>& latencies) {
+    if (latencies.empty()) return;
+    sort(latencies.begin(), latencies.end());
+    step.p50Us = latencies[(latencies.size() - 1) / 2];
+    step.p99Us = latencies[size_t((latencies.size() - 1) * 0.99)];
+    step.maxUs = latencies.back();
+}
+
+size_t readStepRequests(double rate) {
+    return max(MinStepRequests, size_t(rate * StepSeconds));
+}
+
+size_t writeStepRequests(double) {
+    return WriteStepRequests;
+}
+
+// rate between first and last completion, so fixed latency doesn't look like lower throughput
+double completionRate(size_t completed, int64_t first, int64_t last) {
+    if (completed < 2 || last <= first) return 0;
+    return (completed - 1) * 1e6 / (last - first);
+}
+
+// readback request slots shared by sender and receiver thread. slot is published before its hid_write,
+// answer may come before it returns. slot whose write failed is marked and won't get an answer
+struct ReadbackSlots {
+    explicit ReadbackSlots(size_t count) : failed(count) {}
+
+    vector<atomic<bool>> failed;
+    atomic<size_t> published{0};
+    atomic<bool> sending{true};
+    size_t answered = 0;    // receiver side
+
+    // published slots which were sent fine but never answered, call after receiver is joined
+    size_t dropped() const {
+        size_t count = 0;
+        for (size_t i = answered; i < published; ++i) {
+            if (!failed[i]) ++count;
+        }
+        return count;
+    }
+};
+
+// receives two-packet readback answers in request order until sender is done and device is quiet.
+// onAnswer(slot, first, second, now) gets every answer, returns count of answers and packets
+// which didn't fit. with skipOthers packets that aren't readback answers are ignored
+template <typename OnAnswer>
+size_t receiveReadbacks(hid_device* reader, ReadbackSlots& slots, bool skipOthers, OnAnswer onAnswer) {
+    uint8_t first[ReportBufferLength], packet[ReportBufferLength];
+    bool have_first = false;
+    size_t strays = 0;
+    int64_t quiet_since = monotonicMicroseconds();
+
+    while (true) {
+        int bytes = hid_read_timeout(reader, packet, sizeof(packet), 20);
+        int64_t now = monotonicMicroseconds();
+        if (bytes <= 0) {
+            if (!slots.sending && (slots.answered >= slots.published || now - quiet_since > DrainTimeoutMs * 1000)) break;
+            continue;
+        }
+        quiet_since = now;
+
+        if (!have_first) {
+            if (isReadbackHeader(packet)) {
+                memcpy(first, packet, sizeof(first));
+                have_first = true;
+            } else if (!skipOthers) {
+                ++strays; // stray or broken packet, waiting for next header
+            }
+            continue;
+        }
+        have_first = false;
+
+        size_t published = slots.published.load(memory_order_acquire);
+        while (slots.answered < published && slots.failed[slots.answered]) ++slots.answered;
+        if (slots.answered >= published) {
+            ++strays; // answer without request
+            continue;
+        }
+        onAnswer(slots.answered++, first, packet, now);
+    }
+    return strays;
+}
+
+bool answerEquals(const uint8_t* first, const uint8_t* second, const vector<uint8_t>& expected) {
+    return equal(first + 5, first + ReportBufferLength, expected.begin())
+        && equal(second + 5, second + ReportBufferLength, expected.begin() + (ReportBufferLength - 5));
+}
+
+uint8_t stepBrightness(size_t write) {
+    return uint8_t(write % BrightnessLevels);
+}
+
+// writes don't get answers, so every write carries its own LED brightness and every
+// WritesPerReadback-th one is followed by readback expecting just that value.
+// config after the step must hold the value of the last accepted write
+RateStep runWriteStep(hid_device* writer, hid_device* reader, vector<uint8_t> report,
+                      double rate, size_t count, const vector<uint8_t>& reference) {
+    RateStep step;
+    step.offeredRate = rate;
+
+    vector<uint8_t> cmd = {ReportID, 0xa0, 0x01, 0x01};
+    cmd.resize(ReportBufferLength, 0);
+
+    // readbacks share the schedule slot of write they check
+    ReadbackSlots slots(count / WritesPerReadback);
+    vector<uint8_t> expected_brightness(slots.failed.size());
+    size_t corrupted = 0;
+
+    thread receiver([&]() {
+        vector<uint8_t> expected = reference;
+        // write acknowledgements and such must not pile up in kernel queue, they're read and skipped
+        corrupted += receiveReadbacks(reader, slots, true, [&](size_t slot, const uint8_t* first, const uint8_t* second, int64_t) {
+            expected[LEDBrightness - ReadbackShift] = expected_brightness[slot];
+            if (!answerEquals(first, second, expected)) ++corrupted;
+        });
+    });
+
+    vector<double> latencies;
+    latencies.reserve(count);
+    const int64_t start = monotonicMicroseconds() + 1000;
+    int64_t first_done = 0, last_done = 0;
+    bool accepted_any = false;
+    uint8_t last_brightness = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t scheduled = start + int64_t(i * 1e6 / rate);
+        sleepUntil(scheduled);
+        report[1 + LEDBrightness] = stepBrightness(i);
+        int written = hid_write(writer, report.data(), report.size());
+        int64_t done = monotonicMicroseconds();
+        ++step.sent;
+        if (written < 0) {
+            ++step.errors;
+            continue;
+        }
+        accepted_any = true;
+        last_brightness = stepBrightness(i);
+        if (step.verified++ == 0) first_done = done;
+        last_done = done;
+        latencies.push_back(double(done - scheduled));
+
+        size_t slot = i / WritesPerReadback;
+        if (i % WritesPerReadback == WritesPerReadback - 1 && slot < slots.failed.size()) {
+            expected_brightness[slot] = last_brightness;
+            slots.published.store(slot + 1, memory_order_release);
+            if (hid_write(writer, cmd.data(), cmd.size()) < 0) {
+                slots.failed[slot] = true;
+                ++step.errors;
+            }
+        }
+    }
+    slots.sending = false;
+    receiver.join();
+    step.errors += corrupted + slots.dropped();
+    drain(reader, DrainTimeoutMs);
+
+    vector<uint8_t> expected = reference, after;
+    expected[LEDBrightness - ReadbackShift] = last_brightness;
+    if (accepted_any && (!readConfig(writer, reader, after) || after != expected)) {
+        // last write was dropped or some of the writes were taken apart
+        ++step.errors;
+        step.verified = 0;
+    }
+
+    step.achievedRate = completionRate(step.verified, first_done, last_done);
+    fillPercentiles(step, latencies);
+    return step;
+}
+
+// every readback answer is two packets, answers come in request order
+RateStep runReadStep(hid_device* writer, hid_device* reader, double rate, size_t count, const vector<uint8_t>& reference) {
+    RateStep step;
+    step.offeredRate = rate;
+
+    vector<uint8_t> cmd = {ReportID, 0xa0, 0x01, 0x01};
+    cmd.resize(ReportBufferLength, 0);
+
+    vector<int64_t> scheduled(count);
+    ReadbackSlots slots(count);
+
+    vector<double> latencies;
+    latencies.reserve(count);
+    size_t corrupted = 0;
+    int64_t first_answer = 0, last_answer = 0;
+
+    thread receiver([&]() {
+        corrupted += receiveReadbacks(reader, slots, false, [&](size_t slot, const uint8_t* first, const uint8_t* second, int64_t now) {
+            if (!answerEquals(first, second, reference)) {
+                ++corrupted;
+                return;
+            }
+            if (step.verified++ == 0) first_answer = now;
+            last_answer = now;
+            latencies.push_back(double(now - scheduled[slot]));
+        });
+    });
+
+    const int64_t start = monotonicMicroseconds() + 1000;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t at = start + int64_t(i * 1e6 / rate);
+        sleepUntil(at);
+        ++step.sent;
+        scheduled[i] = at;
+        slots.published.store(i + 1, memory_order_release);
+        if (hid_write(writer, cmd.data(), cmd.size()) < 0) {
+            slots.failed[i] = true;
+            ++step.errors;
+        }
+    }
+    slots.sending = false;
+    receiver.join();
+
+    step.errors += corrupted + slots.dropped();
+    step.achievedRate = completionRate(step.verified, first_answer, last_answer);
+    fillPercentiles(step, latencies);
+    return step;
+}
+
+// ramps rate until first errors, saturation or spent request budget, fills max rate, error onset and rate limit
+template <typename RunStep, typename StepSize>
+void ramp(RunStep runStep, StepSize stepSize, size_t budget, hid_device* reader, vector<RateStep>& steps,
+          double& maxRate, double& p99Us, double& errorOnset, double& rateLimit) {
+    size_t used = 0;
+    for (double rate : Rates) {
+        size_t count = stepSize(rate);
+        if (used + count > budget) break;
+        used += count;
+
+        RateStep step = runStep(rate, count);
+        steps.push_back(step);
+        drain(reader, 200);
+
+        if (step.errors > 0) {
+            errorOnset = rate;
+            break;
+        }
+        if (step.achievedRate < step.offeredRate * MinAchievedShare) break;
+        maxRate = rate;
+        p99Us = step.p99Us;
+    }
+    // slowest step failing doesn't mean the device can take anything
+    rateLimit = maxRate > 0 ? maxRate : Rates[0];
+}
+
+}
+
+ThroughputResult characterizeThroughput(const string& devicePath, const vector<uint8_t>& payload, bool testWrites)
+{
+    ThroughputResult result;
+
+    // hidapi handle is not thread-safe, so sender and receiver get their own.
+    // hidraw delivers every input report to every open handle
+    hid_device* writer = hid_open_path(devicePath.c_str());
+    hid_device* reader = hid_open_path(devicePath.c_str());
+    if (!writer || !reader) {
+        result.error = "can't open device";
+        if (writer) hid_close(writer);
+        if (reader) hid_close(reader);
+        return result;
+    }
+
+    vector<uint8_t> report = {ReportID};
+    report.insert(report.end(), payload.begin(), payload.end());
+
+    // reference config is what the device answers, after our payload was written once if writes are tested
+    vector<uint8_t> reference;
+    bool ready = true;
+    if (testWrites) {
+        ready = hid_write(writer, report.data(), report.size()) >= 0;
+        drain(reader, DrainTimeoutMs);
+    }
+    ready = ready && readConfig(writer, reader, reference);
+    drain(reader, 200);
+    if (!ready) {
+        result.error = "can't read back reference config";
+        hid_close(writer);
+        hid_close(reader);
+        return result;
+    }
+
+    if (testWrites) {
+        result.writesTested = true;
+        // two writes go to the reference and to the final restore
+        ramp([&](double rate, size_t count) { return runWriteStep(writer, reader, report, rate, count, reference); },
+             writeStepRequests, MaxConfigWrites - 2,
+             reader, result.writeSteps, result.maxWriteRate, result.writeP99Us, result.writeErrorOnset,
+             result.writeRateLimit);
+
+        // write steps leave brightness changed, intended config must be back before readbacks compare to reference.
+        // restored even if the ramp broke the config
+        drain(reader, DrainTimeoutMs);
+        hid_write(writer, report.data(), report.size());
+        drain(reader, DrainTimeoutMs);
+    }
+    ramp([&](double rate, size_t count) { return runReadStep(writer, reader, rate, count, reference); },
+         readStepRequests, SIZE_MAX,
+         reader, result.readSteps, result.maxReadRate, result.readP99Us, result.readErrorOnset,
+         result.readRateLimit);
+
+    hid_close(writer);
+    hid_close(reader);
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef THROUGHPUTPROBE_H
+#define THROUGHPUTPROBE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// finds how fast the firmware accepts config writes (0xa0 0x01 0x02) and answers
+// readbacks (0xa0 0x01 0x01) before it starts dropping or corrupting reports.
+// load is open-loop: requests go out on fixed schedule no matter if answers came,
+// latency is counted from scheduled send time, so a stalled device can't hide its delays.
+// nobody knows yet if firmware stores every config write in flash, so writes are tested
+// only on request and never more than MaxConfigWrites times per run
+
+const size_t MaxConfigWrites = 300;
+
+struct RateStep {
+    double offeredRate = 0;     // requests per second
+    double achievedRate = 0;    // verified requests per second
+    size_t sent = 0;
+    size_t verified = 0;
+    size_t errors = 0;          // failed writes, dropped, corrupted or wrong answers
+    double p50Us = 0;
+    double p99Us = 0;
+    double maxUs = 0;
+};
+
+struct ThroughputResult {
+    std::string error;          // empty on success
+    bool writesTested = false;
+
+    std::vector<RateStep> writeSteps;
+    std::vector<RateStep> readSteps;
+
+    // highest clean step, 0 if even the slowest one had errors
+    double maxWriteRate = 0;
+    double maxReadRate = 0;
+    double writeP99Us = 0;
+    double readP99Us = 0;
+
+    // first offered rate with errors, 0 if ramp ended without them
+    double writeErrorOnset = 0;
+    double readErrorOnset = 0;
+
+    // rate the app may use: highest clean step, or the slowest offered one if even it had errors
+    double writeRateLimit = 0;
+    double readRateLimit = 0;
+};
+
+// blocks for up to a minute. payload is full write payload (starting with 0xa0 0x01 0x02),
+// with testWrites it's written to the mouse up to MaxConfigWrites times with varying LED brightness,
+// then once more as is, so it should be the config user wants to keep
+ThroughputResult characterizeThroughput(const std::string& devicePath, const std::vector<uint8_t>& payload, bool testWrites);
+
+#endif // THROUGHPUTPROBE_H